@@ -11,13 +11,15 @@
 
 //==============================================================================
 StereoEnhancerAudioProcessorEditor::StereoEnhancerAudioProcessorEditor (StereoEnhancerAudioProcessor& p, juce::AudioProcessorValueTreeState& vts)
-    : AudioProcessorEditor (&p), audioProcessor (p), valueTreeState(vts)
+    : AudioProcessorEditor (&p), audioProcessor (p), valueTreeState(vts), stereoMeter(p.getStereoMeter())
 {	
 	juce::Colour light  = juce::Colour::fromHSV(0.13f, 0.5f, 0.6f, 1.0f);
 	juce::Colour medium = juce::Colour::fromHSV(0.13f, 0.5f, 0.5f, 1.0f);
 	juce::Colour dark   = juce::Colour::fromHSV(0.13f, 0.5f, 0.4f, 1.0f);
 
 	const int fonthHeight = (int)(SLIDER_WIDTH / FONT_DIVISOR);
+	const juce::Font labelFont(fonthHeight, juce::Font::bold);
+	m_labelFontHeight = fonthHeight;
 
 	for (int i = 0; i < N_SLIDERS; i++)
 	{
@@ -26,7 +28,7 @@ StereoEnhancerAudioProcessorEditor::StereoEnhancerAudioProcessorEditor (StereoEn
 
 		//Lable
 		label.setText(StereoEnhancerAudioProcessor::paramsNames[i], juce::dontSendNotification);
-		label.setFont(juce::Font(fonthHeight, juce::Font::bold));
+		label.setFont(labelFont);
 		label.setJustificationType(juce::Justification::centred);
 		addAndMakeVisible(label);
 
@@ -35,9 +37,11 @@ StereoEnhancerAudioProcessorEditor::StereoEnhancerAudioProcessorEditor (StereoEn
 		slider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
 		slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, SLIDER_FONT_SIZE);
 		addAndMakeVisible(slider);
-		m_sliderAttachment[i].reset(new SliderAttachment(valueTreeState, StereoEnhancerAudioProcessor::paramsNames[i], slider));
+		m_sliderAttachment[i].reset(new CoalescedSliderAttachment(*valueTreeState.getParameter(StereoEnhancerAudioProcessor::paramsNames[i]), slider));
 	}
 
+	startTimerHz(REPAINT_RATE_HZ);
+
 	// Buttons
 	addAndMakeVisible(monoButton);
 	monoButton.setClickingTogglesState(true);
@@ -46,31 +50,59 @@ StereoEnhancerAudioProcessorEditor::StereoEnhancerAudioProcessorEditor (StereoEn
 	monoButton.setColour(juce::TextButton::buttonOnColourId, dark);
 	monoButton.setLookAndFeel(&otherLookAndFeel);
 
+	// Meter
+	addAndMakeVisible(stereoMeter);
+
 	// Canvas
 	setResizable(true, true);
-	const float width = SLIDER_WIDTH * N_SLIDERS;
+	const float width = SLIDER_WIDTH * N_COLUMNS;
 	setSize(width, SLIDER_WIDTH);
 
 	if (auto* constrainer = getConstrainer())
 	{
-		constrainer->setFixedAspectRatio(N_SLIDERS);
+		constrainer->setFixedAspectRatio(N_COLUMNS);
 		constrainer->setSizeLimits(width * 0.7f, SLIDER_WIDTH * 0.7, width * 2.0f, SLIDER_WIDTH * 2.0f);
 	}
 }
 
 StereoEnhancerAudioProcessorEditor::~StereoEnhancerAudioProcessorEditor()
 {
+	stopTimer();
 }
 
 //==============================================================================
+void StereoEnhancerAudioProcessorEditor::timerCallback()
+{
+	for (auto& attachment : m_sliderAttachment)
+	{
+		attachment->update();
+	}
+}
+
 void StereoEnhancerAudioProcessorEditor::paint (juce::Graphics& g)
 {
+#if STEREO_ENHANCER_PROFILE_GUI
+	// Skip meter-only frames, they would dilute the knob numbers
+	m_isProfiledFrame = g.getClipBounds().getX() < N_SLIDERS * (getWidth() / N_COLUMNS);
+
+	if (m_isProfiledFrame)
+		m_paintCounter.start();
+#endif
+
 	g.fillAll(juce::Colour::fromHSV(0.13f, 0.5f, 0.7f, 1.0f));
 }
 
+void StereoEnhancerAudioProcessorEditor::paintOverChildren(juce::Graphics&)
+{
+#if STEREO_ENHANCER_PROFILE_GUI
+	if (m_isProfiledFrame)
+		m_paintCounter.stop();
+#endif
+}
+
 void StereoEnhancerAudioProcessorEditor::resized()
 {
-	const int width = (int)(getWidth() / N_SLIDERS);
+	const int width = (int)(getWidth() / N_COLUMNS);
 	const int height = getHeight();
 	const int fonthHeight = (int)(height / FONT_DIVISOR);
 	const int labelOffset = (int)(SLIDER_WIDTH / FONT_DIVISOR) + 5;
@@ -86,12 +118,188 @@ void StereoEnhancerAudioProcessorEditor::resized()
 
 		rectangle.removeFromBottom(labelOffset);
 		m_labels[i].setBounds(rectangle);
+	}
 
-		m_labels[i].setFont(juce::Font(fonthHeight, juce::Font::bold));
+	// Fonts only change when the font height does
+	if (fonthHeight != m_labelFontHeight)
+	{
+		const juce::Font labelFont(fonthHeight, juce::Font::bold);
+		m_labelFontHeight = fonthHeight;
+
+		for (auto& label : m_labels)
+		{
+			label.setFont(labelFont);
+		}
 	}
 
 	// Buttons
 	const int posY = height - (int)(1.8f * fonthHeight);
 
-	monoButton.setBounds((int)(getWidth() * (4.f / 5.0f) - 0.5f * fonthHeight), posY, fonthHeight, fonthHeight);
+	monoButton.setBounds((int)(4 * width - 0.5f * fonthHeight), posY, fonthHeight, fonthHeight);
+
+	// Meter
+	stereoMeter.setBounds(N_SLIDERS * width, 0, getWidth() - N_SLIDERS * width, height);
+}
+
+//==============================================================================
+CoalescedSliderAttachment::CoalescedSliderAttachment(juce::RangedAudioParameter& parameter, juce::Slider& slider) : m_parameter(parameter), m_slider(slider)
+{
+	const auto range = m_parameter.getNormalisableRange();
+
+	m_slider.setNormalisableRange(juce::NormalisableRange<double>(range.start, range.end, range.interval, range.skew, range.symmetricSkew));
+	m_slider.setDoubleClickReturnValue(true, m_parameter.convertFrom0to1(m_parameter.getDefaultValue()));
+	m_slider.textFromValueFunction = [&parameter](double value) { return parameter.getText(parameter.convertTo0to1((float)value), 0); };
+	m_slider.valueFromTextFunction = [&parameter](const juce::String& text) { return (double)parameter.convertFrom0to1(parameter.getValueForText(text)); };
+
+	// User edits go to the host immediately
+	m_slider.onValueChange = [this] { m_parameter.setValueNotifyingHost(m_parameter.convertTo0to1((float)m_slider.getValue())); };
+	m_slider.onDragStart = [this] { m_parameter.beginChangeGesture(); };
+	m_slider.onDragEnd = [this] { m_parameter.endChangeGesture(); };
+
+	m_parameter.addListener(this);
+
+	update();
+	m_slider.updateText();
+}
+
+CoalescedSliderAttachment::~CoalescedSliderAttachment()
+{
+	m_parameter.removeListener(this);
+
+	m_slider.onValueChange = nullptr;
+	m_slider.onDragStart = nullptr;
+	m_slider.onDragEnd = nullptr;
+	m_slider.textFromValueFunction = nullptr;
+	m_slider.valueFromTextFunction = nullptr;
+}
+
+void CoalescedSliderAttachment::update()
+{
+	if (m_dirty.exchange(false))
+	{
+		// No notification, so the change is not sent back to the parameter
+		m_slider.setValue(m_parameter.convertFrom0to1(m_parameter.getValue()), juce::dontSendNotification);
+	}
+}
+
+void CoalescedSliderAttachment::parameterValueChanged(int, float)
+{
+	m_dirty.store(true);
+}
+
+void CoalescedSliderAttachment::parameterGestureChanged(int, bool)
+{
+}
+
+//==============================================================================
+StereoMeterComponent::StereoMeterComponent(StereoMeter& meter) : m_meter(meter)
+{
+	// Drop whatever a previous editor left in the FIFOs
+	StereoMeter::Frame frame;
+	while (m_meter.popFrame(frame)) {}
+
+	juce::Point<float> points[TRAIL_SIZE];
+	while (m_meter.popPoints(points, TRAIL_SIZE) > 0) {}
+
+	// Paints its own full background, the editor below does not need repainting
+	setOpaque(true);
+
+	m_meter.setEnabled(true);
+	startTimerHz(REFRESH_RATE_HZ);
+}
+
+StereoMeterComponent::~StereoMeterComponent()
+{
+	stopTimer();
+	m_meter.setEnabled(false);
+}
+
+void StereoMeterComponent::timerCallback()
+{
+	// Frames arrive at about the refresh rate, only the latest one is shown
+	StereoMeter::Frame frame;
+	bool hasFrame = false;
+
+	while (m_meter.popFrame(frame))
+	{
+		hasFrame = true;
+	}
+
+	if (hasFrame)
+	{
+		m_correlation = frame.correlation;
+		m_sideRatio = frame.sideRatio;
+	}
+
+	// Points go straight into the trail ring buffer
+	int count = 0;
+	int total = 0;
+
+	do
+	{
+		const int space = TRAIL_SIZE - m_trailHead;
+		count = m_meter.popPoints(m_trail + m_trailHead, space);
+
+		m_trailHead = (m_trailHead + count) % TRAIL_SIZE;
+		m_trailCount = juce::jmin(TRAIL_SIZE, m_trailCount + count);
+		total += count;
+	}
+	while (count > 0);
+
+	// Nothing new while the transport is stopped
+	if (hasFrame || total > 0)
+	{
+		repaint();
+	}
+}
+
+void StereoMeterComponent::paint(juce::Graphics& g)
+{
+	g.fillAll(juce::Colour::fromHSV(0.13f, 0.5f, 0.7f, 1.0f));
+
+	auto area = getLocalBounds().toFloat().reduced(getWidth() * 0.08f);
+	const float barHeight = area.getHeight() * 0.06f;
+
+	auto sideBar = area.removeFromBottom(barHeight);
+	area.removeFromBottom(barHeight);
+	auto correlationBar = area.removeFromBottom(barHeight);
+	area.removeFromBottom(barHeight);
+
+	// Goniometer
+	const float size = juce::jmin(area.getWidth(), area.getHeight());
+	auto scope = area.withSizeKeepingCentre(size, size);
+	const float centreX = scope.getCentreX();
+	const float centreY = scope.getCentreY();
+	const float halfSize = 0.5f * size;
+
+	g.setColour(medium);
+	g.drawLine(scope.getX(), centreY, scope.getRight(), centreY, 1.0f);
+	g.drawLine(centreX, scope.getY(), centreX, scope.getBottom(), 1.0f);
+
+	g.setColour(dark);
+
+	for (int i = 0; i < m_trailCount; i++)
+	{
+		const auto& point = m_trail[i];
+		const float x = centreX + halfSize * juce::jlimit(-1.0f, 1.0f, point.x);
+		const float y = centreY - halfSize * juce::jlimit(-1.0f, 1.0f, point.y);
+
+		g.fillRect(x - 1.0f, y - 1.0f, 2.0f, 2.0f);
+	}
+
+	// Correlation, -1 to 1 around the centre
+	g.setColour(light);
+	g.fillRect(correlationBar);
+
+	const float correlationX = correlationBar.getCentreX() + 0.5f * correlationBar.getWidth() * m_correlation;
+
+	g.setColour(dark);
+	g.fillRect(juce::jmin(correlationBar.getCentreX(), correlationX), correlationBar.getY(), std::abs(correlationX - correlationBar.getCentreX()), barHeight);
+
+	// Side energy ratio, 0 to 1 from the left
+	g.setColour(light);
+	g.fillRect(sideBar);
+
+	g.setColour(dark);
+	g.fillRect(sideBar.withWidth(sideBar.getWidth() * m_sideRatio));
 }
\ No newline at end of file
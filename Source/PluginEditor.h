@@ -33,14 +33,17 @@ public:
 		auto radius = ((float)juce::jmin(width / 2, height / 2) - 4.0f) * 0.9f;
 		auto centreX = (float)x + (float)width  * 0.5f;
 		auto centreY = (float)y + (float)height * 0.5f;
-		auto rx = centreX - radius;
-		auto ry = centreY - radius;
-		auto rw = radius * 2.0f;
 		auto angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
 
 		// outline
 		const float lineThickness = 6.0f;
-		
+
+#if STEREO_ENHANCER_UNCACHED_KNOBS
+		// Stroked and built on every repaint, kept to profile against
+		auto rx = centreX - radius;
+		auto ry = centreY - radius;
+		auto rw = radius * 2.0f;
+
 		g.setColour(medium);
 		g.drawEllipse(rx, ry, rw, rw, lineThickness);
 
@@ -53,6 +56,50 @@ public:
 		// pointer
 		g.setColour(medium);
 		g.fillPath(p);
+#else
+		drawCachedOutline(g, centreX, centreY, radius, lineThickness);
+
+		// pointer, built once per size and only transformed here
+		if (radius != m_pointerRadius)
+		{
+			auto pointerLength = radius * 0.2f;
+			auto pointerThickness = lineThickness;
+
+			m_pointerPath.clear();
+			m_pointerPath.addRectangle(-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
+			m_pointerRadius = radius;
+		}
+
+		g.setColour(medium);
+		g.fillPath(m_pointerPath, juce::AffineTransform::rotation(angle).translated(centreX, centreY));
+#endif
+	}
+
+	void drawCachedOutline(juce::Graphics& g, float centreX, float centreY, float radius, float lineThickness)
+	{
+		const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+		// Knob size only changes when the editor is resized
+		if (radius != m_outlineRadius || scale != m_outlineScale)
+		{
+			// Just the knob square, the stroke reaches half its thickness past the radius
+			const int size = juce::jmax(1, (int)std::ceil((2.0f * radius + lineThickness + 2.0f) * scale));
+			const float half = 0.5f * size / scale;
+
+			m_outlineImage = juce::Image(juce::Image::ARGB, size, size, true);
+			juce::Graphics imageGraphics(m_outlineImage);
+			imageGraphics.addTransform(juce::AffineTransform::scale(scale));
+			imageGraphics.setColour(medium);
+			imageGraphics.drawEllipse(half - radius, half - radius, 2.0f * radius, 2.0f * radius, lineThickness);
+
+			m_outlineRadius = radius;
+			m_outlineScale = scale;
+		}
+
+		// Images are drawn with the alpha of the current colour, which is inherited
+		const float half = 0.5f * m_outlineImage.getWidth() / scale;
+		g.setOpacity(1.0f);
+		g.drawImage(m_outlineImage, juce::Rectangle<float>(centreX - half, centreY - half, 2.0f * half, 2.0f * half));
 	}
 
 	juce::Label *createSliderTextBox(juce::Slider &) override
@@ -70,10 +117,71 @@ public:
 		g.setColour(backgroundColour);
 		g.fillRect(buttonArea);
 	}
+
+private:
+	// Pre-rendered knob outline, shared by all sliders of the same size
+	juce::Image m_outlineImage;
+	float m_outlineRadius = 0.0f;
+	float m_outlineScale = 0.0f;
+
+	// Untransformed pointer, rotated into place on every draw
+	juce::Path m_pointerPath;
+	float m_pointerRadius = 0.0f;
+};
+
+//==============================================================================
+class CoalescedSliderAttachment : private juce::AudioProcessorParameter::Listener
+{
+public:
+	CoalescedSliderAttachment(juce::RangedAudioParameter& parameter, juce::Slider& slider);
+	~CoalescedSliderAttachment() override;
+
+	// Message thread, moves the slider to the latest parameter value if it changed
+	void update();
+
+private:
+	// Any thread, only marks the slider as out of date
+	void parameterValueChanged(int parameterIndex, float newValue) override;
+	void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
+
+	juce::RangedAudioParameter& m_parameter;
+	juce::Slider& m_slider;
+
+	std::atomic<bool> m_dirty{ true };
+};
+
+//==============================================================================
+class StereoMeterComponent : public juce::Component, private juce::Timer
+{
+public:
+	StereoMeterComponent(StereoMeter& meter);
+	~StereoMeterComponent() override;
+
+	static const int REFRESH_RATE_HZ = 30;
+	static const int TRAIL_SIZE = 512;
+
+	void paint(juce::Graphics&) override;
+
+private:
+	void timerCallback() override;
+
+	StereoMeter& m_meter;
+
+	juce::Colour light = juce::Colour::fromHSV(0.13f, 0.5f, 0.6f, 1.0f);
+	juce::Colour medium = juce::Colour::fromHSV(0.13f, 0.5f, 0.5f, 1.0f);
+	juce::Colour dark = juce::Colour::fromHSV(0.13f, 0.5f, 0.4f, 1.0f);
+
+	// Goniometer trail, ring buffer of the latest points
+	juce::Point<float> m_trail[TRAIL_SIZE] = {};
+	int m_trailHead = 0;
+	int m_trailCount = 0;
+
+	float m_correlation = 0.0f;
+	float m_sideRatio = 0.0f;
 };
 
 //==============================================================================
-class StereoEnhancerAudioProcessorEditor : public juce::AudioProcessorEditor
+class StereoEnhancerAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
     StereoEnhancerAudioProcessorEditor (StereoEnhancerAudioProcessor&, juce::AudioProcessorValueTreeState&);
@@ -81,19 +189,26 @@ public:
 
 	// GUI setup
 	static const int N_SLIDERS = 5;
+	static const int N_COLUMNS = N_SLIDERS + 1;
 	static const int SLIDER_WIDTH = 140;
 	static const int SLIDER_FONT_SIZE = 20;
 
 	static const int FONT_DIVISOR = 9;
+
+	// Automation driven slider updates are applied at most this often
+	static const int REPAINT_RATE_HZ = 30;
 	
 	//==============================================================================
 	void paint (juce::Graphics&) override;
+	void paintOverChildren(juce::Graphics&) override;
     void resized() override;
 
 	typedef juce::AudioProcessorValueTreeState::SliderAttachment SliderAttachment;
 	typedef juce::AudioProcessorValueTreeState::ComboBoxAttachment ComboBoxAttachment;
 
 private:
+	void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     StereoEnhancerAudioProcessor& audioProcessor;
@@ -104,7 +219,9 @@ private:
 
 	juce::Label m_labels[N_SLIDERS] = {};
 	juce::Slider m_sliders[N_SLIDERS] = {};
-	std::unique_ptr<SliderAttachment> m_sliderAttachment[N_SLIDERS] = {};
+	std::unique_ptr<CoalescedSliderAttachment> m_sliderAttachment[N_SLIDERS] = {};
+
+	int m_labelFontHeight = 0;
 
 	juce::Label automationTLabel;
 	juce::Label smoothingTypeLabel;
@@ -114,5 +231,14 @@ private:
 
 	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> buttonMonoAttachment;
 
+	StereoMeterComponent stereoMeter;
+
+#if STEREO_ENHANCER_PROFILE_GUI
+	// Message thread time per editor frame that repaints any slider, logged every 100 frames.
+	// Build once with STEREO_ENHANCER_UNCACHED_KNOBS=1 for the numbers before knob caching.
+	juce::PerformanceCounter m_paintCounter{ "Editor paint", 100 };
+	bool m_isProfiledFrame = false;
+#endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StereoEnhancerAudioProcessorEditor)
 };
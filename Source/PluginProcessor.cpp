@@ -108,8 +108,211 @@ float FirstOrderAllPass::process(float in)
 }
 
 //==============================================================================
+StereoMeter::StereoMeter()
+{
+}
+
+void StereoMeter::init(int sampleRate)
+{
+	m_windowSize = juce::jmax(1, sampleRate / FRAMES_PER_SECOND);
+	reset();
+}
+
+void StereoMeter::setEnabled(bool enabled)
+{
+	m_enabled.store(enabled, std::memory_order_release);
+}
+
+bool StereoMeter::isEnabled() const
+{
+	return m_enabled.load(std::memory_order_acquire);
+}
+
+void StereoMeter::reset()
+{
+	m_windowCount = 0;
+	m_nextPoint = 0;
+
+	m_sumLL = 0.0f;
+	m_sumRR = 0.0f;
+	m_sumLR = 0.0f;
+}
+
+void StereoMeter::process(const float* left, const float* right, int samples)
+{
+	// Nobody is reading, skip all metering work
+	if (!isEnabled())
+	{
+		m_wasEnabled = false;
+		return;
+	}
+
+	// Start a fresh window after the reader was (re)attached
+	if (!m_wasEnabled)
+	{
+		reset();
+		m_wasEnabled = true;
+	}
+
+	pushPoints(left, right, samples);
+
+	// Split the block at window boundaries
+	int offset = 0;
+
+	while (offset < samples)
+	{
+		const int count = juce::jmin(samples - offset, m_windowSize - m_windowCount);
+
+		accumulate(left + offset, right + offset, count);
+
+		offset += count;
+		m_windowCount += count;
+
+		if (m_windowCount >= m_windowSize)
+		{
+			pushFrame();
+
+			m_windowCount = 0;
+			m_sumLL = 0.0f;
+			m_sumRR = 0.0f;
+			m_sumLR = 0.0f;
+		}
+	}
+}
+
+void StereoMeter::accumulate(const float* left, const float* right, int samples)
+{
+	// Independent lanes let the compiler vectorize the reduction
+	const int LANES = 4;
+
+	float sumLL[LANES] = {};
+	float sumRR[LANES] = {};
+	float sumLR[LANES] = {};
+
+	int sample = 0;
+
+	for (; sample + LANES <= samples; sample += LANES)
+	{
+		for (int lane = 0; lane < LANES; lane++)
+		{
+			const float l = left[sample + lane];
+			const float r = right[sample + lane];
+
+			sumLL[lane] += l * l;
+			sumRR[lane] += r * r;
+			sumLR[lane] += l * r;
+		}
+	}
+
+	for (; sample < samples; sample++)
+	{
+		const float l = left[sample];
+		const float r = right[sample];
+
+		sumLL[0] += l * l;
+		sumRR[0] += r * r;
+		sumLR[0] += l * r;
+	}
+
+	m_sumLL += (sumLL[0] + sumLL[1]) + (sumLL[2] + sumLL[3]);
+	m_sumRR += (sumRR[0] + sumRR[1]) + (sumRR[2] + sumRR[3]);
+	m_sumLR += (sumLR[0] + sumLR[1]) + (sumLR[2] + sumLR[3]);
+}
+
+void StereoMeter::pushPoints(const float* left, const float* right, int samples)
+{
+	const int first = m_nextPoint;
+
+	if (first >= samples)
+	{
+		m_nextPoint -= samples;
+		return;
+	}
+
+	const int count = (samples - first - 1) / POINTS_DECIMATION + 1;
+	m_nextPoint = first + count * POINTS_DECIMATION - samples;
+
+	// Points that do not fit are dropped, the reader is behind anyway
+	int start1, size1, start2, size2;
+	m_pointFifo.prepareToWrite(count, start1, size1, start2, size2);
+
+	const float scale = 0.70710678f;
+	int sample = first;
+
+	for (int i = 0; i < size1 + size2; i++, sample += POINTS_DECIMATION)
+	{
+		const float l = left[sample];
+		const float r = right[sample];
+
+		// x = side, y = mid
+		m_points[i < size1 ? start1 + i : start2 + i - size1] = { scale * (l - r), scale * (l + r) };
+	}
+
+	m_pointFifo.finishedWrite(size1 + size2);
+}
+
+void StereoMeter::pushFrame()
+{
+	const float energy = m_sumLL + m_sumRR;
+	const float epsilon = 1e-12f;
+
+	Frame frame;
+
+	if (energy > epsilon)
+	{
+		const float product = m_sumLL * m_sumRR;
+
+		frame.correlation = product > epsilon ? juce::jlimit(-1.0f, 1.0f, m_sumLR / sqrtf(product)) : 0.0f;
+		frame.sideRatio = juce::jlimit(0.0f, 1.0f, 0.5f - m_sumLR / energy);
+	}
+
+	int start1, size1, start2, size2;
+	m_frameFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+	if (size1 > 0)
+	{
+		m_frames[start1] = frame;
+	}
 
-const std::string StereoEnhancerAudioProcessor::paramsNames[] = { "Intensity", "HPFilter", "LPFilter", "Width", "Volume" };
+	m_frameFifo.finishedWrite(size1);
+}
+
+bool StereoMeter::popFrame(Frame& frame)
+{
+	int start1, size1, start2, size2;
+	m_frameFifo.prepareToRead(1, start1, size1, start2, size2);
+
+	if (size1 > 0)
+	{
+		frame = m_frames[start1];
+	}
+
+	m_frameFifo.finishedRead(size1);
+
+	return size1 > 0;
+}
+
+int StereoMeter::popPoints(juce::Point<float>* points, int maxPoints)
+{
+	int start1, size1, start2, size2;
+	m_pointFifo.prepareToRead(maxPoints, start1, size1, start2, size2);
+
+	std::copy(m_points + start1, m_points + start1 + size1, points);
+	std::copy(m_points + start2, m_points + start2 + size2, points + size1);
+
+	m_pointFifo.finishedRead(size1 + size2);
+
+	return size1 + size2;
+}
+
+//==============================================================================
+
+const std::string StereoEnhancerAudioProcessor::paramsNames[N_PARAMS] = { "Intensity", "HPFilter", "LPFilter", "Width", "Volume" };
+
+// Binary state layout, never reorder or remove entries, only append
+const std::string StereoEnhancerAudioProcessor::stateParamsNames[] = { "Intensity", "HPFilter", "LPFilter", "Width", "Volume", "ButtonMono" };
+
+static_assert(sizeof(StereoEnhancerAudioProcessor::stateParamsNames) / sizeof(StereoEnhancerAudioProcessor::stateParamsNames[0]) == StereoEnhancerAudioProcessor::N_STATE_PARAMS, "stateParamsNames must list N_STATE_PARAMS entries");
 
 //==============================================================================
 StereoEnhancerAudioProcessor::StereoEnhancerAudioProcessor()
@@ -131,6 +334,12 @@ StereoEnhancerAudioProcessor::StereoEnhancerAudioProcessor()
 	volumeParameter    = apvts.getRawParameterValue(paramsNames[4]);
 
 	buttonMonoParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("ButtonMono"));
+
+	for (int i = 0; i < N_STATE_PARAMS; i++)
+	{
+		m_stateParameters[i] = apvts.getParameter(stateParamsNames[i]);
+		m_stateValues[i] = apvts.getRawParameterValue(stateParamsNames[i]);
+	}
 }
 
 StereoEnhancerAudioProcessor::~StereoEnhancerAudioProcessor()
@@ -211,6 +420,8 @@ void StereoEnhancerAudioProcessor::prepareToPlay (double sampleRate, int samples
 
 	m_lowPassFilter.init(sr);
 	m_highPassFilter.init(sr);
+
+	m_stereoMeter.init(sr);
 }
 
 void StereoEnhancerAudioProcessor::releaseResources()
@@ -319,6 +530,9 @@ void StereoEnhancerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
 			rightChannelBuffer[sample] = volume * (inMid - inSide - inAllPassWidth);
 		}
 	}
+
+	// Metering, no-op while no editor is open
+	m_stereoMeter.process(leftChannelBuffer, rightChannelBuffer, samples);
 }
 
 //==============================================================================
@@ -335,13 +549,61 @@ juce::AudioProcessorEditor* StereoEnhancerAudioProcessor::createEditor()
 //==============================================================================
 void StereoEnhancerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {	
-	auto state = apvts.copyState();
-	std::unique_ptr<juce::XmlElement> xml(state.createXml());
-	copyXmlToBinary(*xml, destData);
+	// Raw parameter values, no XML or ValueTree involved
+	juce::MemoryOutputStream stream(destData, false);
+	stream.preallocate(STATE_HEADER_SIZE + N_STATE_PARAMS * sizeof(float));
+
+	stream.writeInt(STATE_MAGIC);
+	stream.writeInt(STATE_VERSION);
+	stream.writeInt(N_STATE_PARAMS);
+
+	for (int i = 0; i < N_STATE_PARAMS; i++)
+	{
+		stream.writeFloat(m_stateValues[i]->load());
+	}
 }
 
 void StereoEnhancerAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+	// Binary state
+	if (sizeInBytes >= STATE_HEADER_SIZE && (int)juce::ByteOrder::littleEndianInt(data) == STATE_MAGIC)
+	{
+		juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+
+		stream.readInt(); // magic
+		const int version = stream.readInt();
+		const int count = stream.readInt();
+
+		if (version < 1)
+			return;
+
+		// Newer versions only append parameters, read the ones we know
+		const int available = (sizeInBytes - STATE_HEADER_SIZE) / (int)sizeof(float);
+		const int n = juce::jmin(count, available, N_STATE_PARAMS);
+
+		for (int i = 0; i < n; i++)
+		{
+			const float value = stream.readFloat();
+
+			// Corrupted blob, keep the current value rather than feed NaN to the filters
+			if (!std::isfinite(value))
+				continue;
+
+			auto* parameter = m_stateParameters[i];
+			parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+		}
+
+		// Parameters the blob does not have get their defaults, like the XML path
+		for (int i = n; i < N_STATE_PARAMS; i++)
+		{
+			auto* parameter = m_stateParameters[i];
+			parameter->setValueNotifyingHost(parameter->getDefaultValue());
+		}
+
+		return;
+	}
+
+	// Legacy XML state
 	std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
 	if (xmlState.get() != nullptr)
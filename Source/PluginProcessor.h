@@ -59,6 +59,58 @@ protected:
 	float m_d = 0.0f;   // history d = x[n-1] - a1y[n-1]
 };
 
+//==============================================================================
+class StereoMeter
+{
+public:
+	struct Frame
+	{
+		float correlation = 0.0f; // -1 out of phase, 0 uncorrelated, 1 mono
+		float sideRatio = 0.0f;   // side energy / (mid + side energy), 0 mono, 0.5 uncorrelated, 1 out of phase
+	};
+
+	StereoMeter();
+
+	void init(int sampleRate);
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	// Audio thread only, wait-free
+	void process(const float* left, const float* right, int samples);
+
+	// Reader thread only, wait-free
+	bool popFrame(Frame& frame);
+	int popPoints(juce::Point<float>* points, int maxPoints);
+
+	static const int FRAMES_PER_SECOND = 30;
+	static const int POINTS_DECIMATION = 16;
+	static const int FRAME_FIFO_SIZE = 64;
+	static const int POINT_FIFO_SIZE = 8192;
+
+protected:
+	void reset();
+	void accumulate(const float* left, const float* right, int samples);
+	void pushPoints(const float* left, const float* right, int samples);
+	void pushFrame();
+
+	juce::AbstractFifo m_frameFifo{ FRAME_FIFO_SIZE };
+	juce::AbstractFifo m_pointFifo{ POINT_FIFO_SIZE };
+	Frame m_frames[FRAME_FIFO_SIZE] = {};
+	juce::Point<float> m_points[POINT_FIFO_SIZE] = {};
+
+	std::atomic<bool> m_enabled{ false };
+	bool m_wasEnabled = false;
+
+	int m_windowSize = 1;
+	int m_windowCount = 0;
+	int m_nextPoint = 0;
+
+	// Running sums over the current window
+	float m_sumLL = 0.0f;
+	float m_sumRR = 0.0f;
+	float m_sumLR = 0.0f;
+};
+
 //==============================================================================
 class StereoEnhancerAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
@@ -72,7 +124,17 @@ public:
     ~StereoEnhancerAudioProcessor() override;
 
 	static const int N_ALL_PASS_FO = 100;
-	static const std::string paramsNames[];
+	static const int N_PARAMS = 5;
+	static const std::string paramsNames[N_PARAMS];
+
+	// Binary state: magic, version, parameter count, then one float per parameter.
+	// Parameters are stored in stateParamsNames order. That table is the on-disk layout,
+	// independent of paramsNames; existing entries are frozen, new ones go at the end.
+	static const int STATE_MAGIC = 0x686e4553; // "SEnh"
+	static const int STATE_VERSION = 1;
+	static const int STATE_HEADER_SIZE = 3 * sizeof(int);
+	static const int N_STATE_PARAMS = 6;
+	static const std::string stateParamsNames[];
 
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
@@ -121,6 +183,8 @@ public:
 
 	APVTS apvts{ *this, nullptr, "Parameters", createParameterLayout() };
 
+	StereoMeter& getStereoMeter() { return m_stereoMeter; }
+
 private:	
 	//==============================================================================
 
@@ -132,9 +196,14 @@ private:
 
 	juce::AudioParameterBool* buttonMonoParameter = nullptr;
 
+	juce::RangedAudioParameter* m_stateParameters[N_STATE_PARAMS] = {};
+	std::atomic<float>* m_stateValues[N_STATE_PARAMS] = {};
+
 	FirstOrderAllPass m_firstOrderAllPass[N_ALL_PASS_FO] = {};
 	LinkwitzRileySecondOrder m_lowPassFilter = {};
 	LinkwitzRileySecondOrder m_highPassFilter = {};
 
+	StereoMeter m_stereoMeter;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StereoEnhancerAudioProcessor)
 };
@@ -0,0 +1,540 @@
+/*
+  ==============================================================================
+
+    Golden reference accuracy test and ns/sample regression check of the DSP.
+
+  ==============================================================================
+*/
+
+#include "Tests.h"
+#include "../../Source/PluginProcessor.h"
+
+#include <complex>
+
+//==============================================================================
+static const int SAMPLE_RATE = 48000;
+static const int BLOCK_SIZE = 512;
+static const int N_SAMPLES = 32768;
+static const int N_PERF_RUNS = 5;
+
+static const double PROBE_FREQUENCIES[] = { 100.0, 1000.0, 5000.0, 15000.0 };
+
+// Per-metric tolerances
+static const double MAGNITUDE_TOLERANCE_DB = 0.05;
+static const double PHASE_TOLERANCE_DEG = 0.5;
+static const double PHASE_MIN_MAGNITUDE_DB = -60.0; // phase of weaker bins is not compared
+static const double NULL_DEPTH_LIMIT_DB = -60.0;    // residual against the golden render, per channel
+static const double DB_FLOOR = -200.0;
+
+// Golden renders keep every RENDER_DECIMATION-th output sample
+static const int RENDER_DECIMATION = 32;
+static const int RENDER_MAGIC = 0x72674553; // "SEgr"
+
+static const double DEFAULT_PERF_THRESHOLD = 1.2;
+
+static const char* GOLDEN_FILE_NAME = "golden_reference.txt";
+static const char* RENDER_FILE_NAME = "golden_renders.bin";
+static const char* BASELINE_FILE_NAME = "perf_baseline.txt";
+
+//==============================================================================
+struct Signal
+{
+	juce::String name;
+	std::vector<float> left;
+	std::vector<float> right;
+};
+
+struct Settings
+{
+	float intensity;
+	float width;
+	float hpFilter;
+	float lpFilter;
+};
+
+typedef std::map<juce::String, double> Metrics;
+typedef std::map<juce::String, std::vector<float>> Renders;
+
+//==============================================================================
+static std::vector<Signal> createSignals()
+{
+	std::vector<Signal> signals(4);
+
+	for (auto& signal : signals)
+	{
+		signal.left.assign(N_SAMPLES, 0.0f);
+		signal.right.assign(N_SAMPLES, 0.0f);
+	}
+
+	// Left only impulse, excites both mid and side
+	signals[0].name = "impulse";
+	signals[0].left[0] = 1.0f;
+
+	// Logarithmic sine sweep 20 Hz - 20 kHz, partly correlated
+	signals[1].name = "sweep";
+	const double f0 = 20.0;
+	const double f1 = 20000.0;
+	const double duration = (double)N_SAMPLES / SAMPLE_RATE;
+	const double k = std::log(f1 / f0);
+
+	for (int i = 0; i < N_SAMPLES; i++)
+	{
+		const double t = (double)i / SAMPLE_RATE;
+		const double phase = 2.0 * juce::MathConstants<double>::pi * f0 * duration / k * (std::exp(t * k / duration) - 1.0);
+
+		signals[1].left[i] = (float)(0.5 * std::sin(phase));
+		signals[1].right[i] = 0.3f * signals[1].left[i];
+	}
+
+	// Uncorrelated white noise, fixed seed LCG so every platform renders the same input
+	signals[2].name = "noise";
+	juce::uint32 seed = 12345;
+
+	for (int i = 0; i < N_SAMPLES; i++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		signals[2].left[i] = (float)(seed >> 8) / 16777216.0f - 0.5f;
+
+		seed = seed * 1664525u + 1013904223u;
+		signals[2].right[i] = (float)(seed >> 8) / 16777216.0f - 0.5f;
+	}
+
+	signals[3].name = "silence";
+
+	return signals;
+}
+
+static std::vector<Settings> createSettings()
+{
+	std::vector<Settings> settings;
+
+	const float intensities[] = { 0.0f, 0.5f, 1.0f };
+	const float widths[] = { 0.0f, 0.5f, 1.0f };
+	const float filters[][2] = { { 20.0f, 20000.0f }, { 200.0f, 8000.0f } };
+
+	for (auto intensity : intensities)
+		for (auto width : widths)
+			for (auto& filter : filters)
+				settings.push_back({ intensity, width, filter[0], filter[1] });
+
+	return settings;
+}
+
+static juce::String getCaseName(const Signal& signal, const Settings& settings)
+{
+	return signal.name
+		+ "_i" + juce::String(settings.intensity, 2)
+		+ "_w" + juce::String(settings.width, 2)
+		+ "_hp" + juce::String((int)settings.hpFilter)
+		+ "_lp" + juce::String((int)settings.lpFilter);
+}
+
+//==============================================================================
+static void setParameter(StereoEnhancerAudioProcessor& processor, const std::string& name, float value)
+{
+	auto* parameter = processor.apvts.getParameter(name);
+	parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+static void render(StereoEnhancerAudioProcessor& processor, const Settings& settings, const Signal& input, Signal& output)
+{
+	setParameter(processor, "Intensity", settings.intensity);
+	setParameter(processor, "HPFilter", settings.hpFilter);
+	setParameter(processor, "LPFilter", settings.lpFilter);
+	setParameter(processor, "Width", settings.width);
+	setParameter(processor, "Volume", 0.0f);
+	setParameter(processor, "ButtonMono", 0.0f);
+
+	processor.prepareToPlay(SAMPLE_RATE, BLOCK_SIZE);
+
+	output.left = input.left;
+	output.right = input.right;
+
+	juce::AudioBuffer<float> buffer(2, BLOCK_SIZE);
+	juce::MidiBuffer midi;
+
+	for (int start = 0; start < N_SAMPLES; start += BLOCK_SIZE)
+	{
+		const int samples = juce::jmin(BLOCK_SIZE, N_SAMPLES - start);
+
+		buffer.setSize(2, samples, false, false, true);
+		buffer.copyFrom(0, 0, output.left.data() + start, samples);
+		buffer.copyFrom(1, 0, output.right.data() + start, samples);
+
+		processor.processBlock(buffer, midi);
+
+		std::copy(buffer.getReadPointer(0), buffer.getReadPointer(0) + samples, output.left.data() + start);
+		std::copy(buffer.getReadPointer(1), buffer.getReadPointer(1) + samples, output.right.data() + start);
+	}
+}
+
+//==============================================================================
+static double toDb(double gain)
+{
+	return gain > 0.0 ? juce::jmax(DB_FLOOR, 20.0 * std::log10(gain)) : DB_FLOOR;
+}
+
+static double rms(const std::vector<float>& samples)
+{
+	double sum = 0.0;
+
+	for (auto sample : samples)
+		sum += (double)sample * sample;
+
+	return std::sqrt(sum / samples.size());
+}
+
+static std::complex<double> dft(const std::vector<float>& samples, double frequency)
+{
+	const double w = 2.0 * juce::MathConstants<double>::pi * frequency / SAMPLE_RATE;
+	std::complex<double> sum = 0.0;
+
+	for (size_t i = 0; i < samples.size(); i++)
+		sum += (double)samples[i] * std::polar(1.0, -w * i);
+
+	return sum;
+}
+
+static std::vector<float> decimate(const std::vector<float>& samples)
+{
+	std::vector<float> decimated;
+
+	for (size_t i = 0; i < samples.size(); i += RENDER_DECIMATION)
+		decimated.push_back(samples[i]);
+
+	return decimated;
+}
+
+static double nullDepth(const std::vector<float>& render, const std::vector<float>& golden)
+{
+	// Residual of the render against the golden render, relative to the golden level
+	std::vector<float> residual(render.size());
+
+	for (size_t i = 0; i < render.size(); i++)
+		residual[i] = render[i] - golden[i];
+
+	const double goldenRms = rms(golden);
+
+	return goldenRms > 0.0 ? toDb(rms(residual) / goldenRms) : toDb(rms(residual));
+}
+
+static void measure(const juce::String& caseName, const Signal& input, const Signal& output, Metrics& metrics, Renders& renders)
+{
+	metrics[caseName + " rms_L"] = toDb(rms(output.left));
+	metrics[caseName + " rms_R"] = toDb(rms(output.right));
+
+	renders[caseName + " L"] = decimate(output.left);
+	renders[caseName + " R"] = decimate(output.right);
+
+	// Transfer function at the probe frequencies, the impulse response is the transfer function
+	if (input.name != "impulse")
+		return;
+
+	for (auto frequency : PROBE_FREQUENCIES)
+	{
+		const juce::String suffix = "_" + juce::String((int)frequency);
+		const auto left = dft(output.left, frequency);
+		const auto right = dft(output.right, frequency);
+
+		metrics[caseName + " mag_L" + suffix] = toDb(std::abs(left));
+		metrics[caseName + " mag_R" + suffix] = toDb(std::abs(right));
+		metrics[caseName + " phase_L" + suffix] = juce::radiansToDegrees(std::arg(left));
+		metrics[caseName + " phase_R" + suffix] = juce::radiansToDegrees(std::arg(right));
+	}
+}
+
+//==============================================================================
+static bool compare(const juce::String& key, double value, const Metrics& measured, const Metrics& golden)
+{
+	const auto metric = key.fromFirstOccurrenceOf(" ", false, false);
+	const double expected = golden.at(key);
+
+	if (metric.startsWith("phase"))
+	{
+		// Phase of a bin without energy is noise
+		const auto magnitudeKey = key.replace(" phase", " mag");
+
+		if (golden.at(magnitudeKey) < PHASE_MIN_MAGNITUDE_DB && measured.at(magnitudeKey) < PHASE_MIN_MAGNITUDE_DB)
+			return true;
+
+		const double difference = std::remainder(value - expected, 360.0);
+		return std::abs(difference) <= PHASE_TOLERANCE_DEG;
+	}
+
+	return std::abs(value - expected) <= MAGNITUDE_TOLERANCE_DB;
+}
+
+static Metrics readMetrics(const juce::File& file)
+{
+	Metrics metrics;
+	juce::StringArray lines;
+	file.readLines(lines);
+
+	for (const auto& line : lines)
+	{
+		const auto tokens = juce::StringArray::fromTokens(line, " ", "");
+
+		if (tokens.size() == 3 && !line.startsWith("#"))
+			metrics[tokens[0] + " " + tokens[1]] = tokens[2].getDoubleValue();
+	}
+
+	return metrics;
+}
+
+static void writeMetrics(const juce::File& file, const juce::String& header, const Metrics& metrics)
+{
+	juce::String text = "# " + header + "\n";
+
+	for (const auto& metric : metrics)
+		text << metric.first << " " << juce::String(metric.second, 6) << "\n";
+
+	file.replaceWithText(text);
+}
+
+static Renders readRenders(const juce::File& file)
+{
+	Renders renders;
+	juce::FileInputStream stream(file);
+
+	if (!stream.openedOk() || stream.readInt() != RENDER_MAGIC)
+		return renders;
+
+	const int count = stream.readInt();
+	const int length = stream.readInt();
+
+	for (int i = 0; i < count && !stream.isExhausted(); i++)
+	{
+		auto& render = renders[stream.readString()];
+		render.resize((size_t)length);
+
+		for (auto& sample : render)
+			sample = stream.readFloat();
+	}
+
+	return renders;
+}
+
+static void writeRenders(const juce::File& file, const Renders& renders)
+{
+	file.deleteFile();
+	juce::FileOutputStream stream(file);
+
+	stream.writeInt(RENDER_MAGIC);
+	stream.writeInt((int)renders.size());
+	stream.writeInt(N_SAMPLES / RENDER_DECIMATION);
+
+	for (const auto& render : renders)
+	{
+		stream.writeString(render.first);
+
+		for (auto sample : render.second)
+			stream.writeFloat(sample);
+	}
+}
+
+//==============================================================================
+static double measureNsPerSample(const std::vector<Signal>& signals)
+{
+	// Worst case, the full all-pass cascade
+	const Settings settings = { 1.0f, 1.0f, 20.0f, 20000.0f };
+	const Signal& input = signals[2];
+
+	StereoEnhancerAudioProcessor processor;
+	Signal output;
+	double best = std::numeric_limits<double>::max();
+
+	for (int run = 0; run < N_PERF_RUNS; run++)
+	{
+		const double start = juce::Time::getMillisecondCounterHiRes();
+		render(processor, settings, input, output);
+		const double elapsed = juce::Time::getMillisecondCounterHiRes() - start;
+
+		best = juce::jmin(best, elapsed * 1.0e6 / N_SAMPLES);
+	}
+
+	return best;
+}
+
+static juce::File findGoldenDirectory()
+{
+	// Tests/Golden above the working directory or the executable, wherever the build tree is
+	const juce::File starts[] = { juce::File::getCurrentWorkingDirectory(), juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory() };
+
+	for (auto directory : starts)
+	{
+		for (; directory != directory.getParentDirectory(); directory = directory.getParentDirectory())
+		{
+			if (directory.getChildFile(GOLDEN_FILE_NAME).existsAsFile())
+				return directory;
+
+			if (directory.getChildFile("Golden").getChildFile(GOLDEN_FILE_NAME).existsAsFile())
+				return directory.getChildFile("Golden");
+
+			if (directory.getChildFile("Tests").getChildFile("Golden").getChildFile(GOLDEN_FILE_NAME).existsAsFile())
+				return directory.getChildFile("Tests").getChildFile("Golden");
+		}
+	}
+
+	return {};
+}
+
+bool runGoldenTests(const juce::StringArray& args)
+{
+	const bool updateGolden = args.contains("--update-golden");
+	const bool updateBaseline = args.contains("--update-baseline");
+	const bool skipPerf = args.contains("--no-perf");
+
+	double perfThreshold = DEFAULT_PERF_THRESHOLD;
+	const int thresholdIndex = args.indexOf("--perf-threshold");
+
+	if (thresholdIndex >= 0)
+	{
+		perfThreshold = args[thresholdIndex + 1].getDoubleValue();
+
+		if (!(perfThreshold > 0.0))
+		{
+			std::cout << "--perf-threshold needs a positive ratio, e.g. --perf-threshold 1.2" << std::endl;
+			return false;
+		}
+	}
+
+	juce::File directory;
+	const int directoryIndex = args.indexOf("--golden-dir");
+
+	if (directoryIndex >= 0)
+	{
+		if (args[directoryIndex + 1].isEmpty())
+		{
+			std::cout << "--golden-dir needs a directory" << std::endl;
+			return false;
+		}
+
+		directory = juce::File::getCurrentWorkingDirectory().getChildFile(args[directoryIndex + 1]);
+	}
+	else
+	{
+		directory = findGoldenDirectory();
+
+		if (directory == juce::File())
+		{
+			std::cout << "Golden reference directory not found, pass --golden-dir" << std::endl;
+			return false;
+		}
+	}
+
+	std::cout << "Golden reference test, " << directory.getFullPathName() << std::endl;
+
+	// Accuracy
+	const auto signals = createSignals();
+	const auto settings = createSettings();
+	Metrics measured;
+	Renders renders;
+
+	for (const auto& setting : settings)
+	{
+		for (const auto& signal : signals)
+		{
+			StereoEnhancerAudioProcessor processor;
+			Signal output;
+
+			render(processor, setting, signal, output);
+			measure(getCaseName(signal, setting), signal, output, measured, renders);
+		}
+	}
+
+	const auto goldenFile = directory.getChildFile(GOLDEN_FILE_NAME);
+	const auto renderFile = directory.getChildFile(RENDER_FILE_NAME);
+	bool passed = true;
+
+	if (updateGolden)
+	{
+		directory.createDirectory();
+		writeMetrics(goldenFile, "case metric value, regenerate with --update-golden", measured);
+		writeRenders(renderFile, renders);
+		std::cout << "  wrote " << measured.size() << " golden metrics and " << renders.size() << " golden renders" << std::endl;
+	}
+	else
+	{
+		const auto golden = readMetrics(goldenFile);
+		const auto goldenRenders = readRenders(renderFile);
+		int failures = 0;
+
+		// Null depth against the stored renders, catches any change of the output waveform
+		for (const auto& render : renders)
+		{
+			const auto key = render.first.replace(" L", " null_L").replace(" R", " null_R");
+			const auto goldenRender = goldenRenders.find(render.first);
+
+			if (goldenRender == goldenRenders.end() || goldenRender->second.size() != render.second.size())
+			{
+				std::cout << "  missing golden render " << render.first << std::endl;
+				failures++;
+				continue;
+			}
+
+			const double depth = nullDepth(render.second, goldenRender->second);
+
+			if (!(depth <= NULL_DEPTH_LIMIT_DB))
+			{
+				std::cout << "  " << key << " " << depth << " dB, limit " << NULL_DEPTH_LIMIT_DB << " dB" << std::endl;
+				failures++;
+			}
+		}
+
+		for (const auto& metric : measured)
+		{
+			if (golden.count(metric.first) == 0)
+			{
+				std::cout << "  missing golden value " << metric.first << std::endl;
+				failures++;
+			}
+			else if (!compare(metric.first, metric.second, measured, golden))
+			{
+				std::cout << "  " << metric.first << " " << metric.second << ", expected " << golden.at(metric.first) << std::endl;
+				failures++;
+			}
+		}
+
+		const int total = (int)(measured.size() + renders.size());
+		std::cout << "  " << total - failures << "/" << total << " metrics within tolerance" << std::endl;
+		passed &= failures == 0;
+	}
+
+	// Performance
+	if (skipPerf)
+	{
+		std::cout << "  performance check skipped" << std::endl;
+		return passed;
+	}
+
+	const double nsPerSample = measureNsPerSample(signals);
+	const auto baselineFile = directory.getChildFile(BASELINE_FILE_NAME);
+	const juce::String key = "perf ns_per_sample";
+
+	if (updateBaseline)
+	{
+		directory.createDirectory();
+		writeMetrics(baselineFile, "machine specific, regenerate with --update-baseline", { { key, nsPerSample } });
+		std::cout << "  wrote baseline " << nsPerSample << " ns/sample" << std::endl;
+	}
+	else
+	{
+		const auto baseline = readMetrics(baselineFile);
+
+		if (baseline.count(key) == 0)
+		{
+			std::cout << "  " << nsPerSample << " ns/sample, no baseline, run with --update-baseline or --no-perf" << std::endl;
+			passed = false;
+		}
+		else
+		{
+			const double limit = baseline.at(key) * perfThreshold;
+			const bool fast = nsPerSample <= limit;
+
+			std::cout << "  " << nsPerSample << " ns/sample, baseline " << baseline.at(key) << ", limit " << limit << (fast ? "" : " REGRESSED") << std::endl;
+			passed &= fast;
+		}
+	}
+
+	return passed;
+}
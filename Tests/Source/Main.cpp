@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+
+    Console runner for the StereoEnhancer tests and benchmarks.
+
+  ==============================================================================
+*/
+
+#include "Tests.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+	// Processors and their parameter trees need the message manager
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	juce::StringArray args;
+
+	for (int i = 1; i < argc; i++)
+		args.add(argv[i]);
+
+	bool passed = true;
+
+	passed &= runGoldenTests(args);
+	passed &= runStateBenchmark();
+
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	return passed ? 0 : 1;
+}
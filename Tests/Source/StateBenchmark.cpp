@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    Save/load timing of the binary and the legacy XML state for many instances.
+
+  ==============================================================================
+*/
+
+#include "Tests.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+static const int N_INSTANCES = 1000;
+
+static void setTestValues(StereoEnhancerAudioProcessor& processor)
+{
+	const float values[StereoEnhancerAudioProcessor::N_STATE_PARAMS] = { 0.73f, 120.0f, 9000.0f, 0.25f, -3.5f, 1.0f };
+
+	for (int i = 0; i < StereoEnhancerAudioProcessor::N_STATE_PARAMS; i++)
+	{
+		auto* parameter = processor.apvts.getParameter(StereoEnhancerAudioProcessor::stateParamsNames[i]);
+		parameter->setValueNotifyingHost(parameter->convertTo0to1(values[i]));
+	}
+}
+
+static bool hasSameValues(StereoEnhancerAudioProcessor& a, StereoEnhancerAudioProcessor& b)
+{
+	for (int i = 0; i < StereoEnhancerAudioProcessor::N_STATE_PARAMS; i++)
+	{
+		const auto name = StereoEnhancerAudioProcessor::stateParamsNames[i];
+
+		const float difference = std::abs(a.apvts.getRawParameterValue(name)->load() - b.apvts.getRawParameterValue(name)->load());
+
+		// Written so that a NaN on either side counts as a mismatch
+		if (!(difference <= 1e-4f))
+		{
+			std::cout << "  mismatch in " << name << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static juce::MemoryBlock createLegacyState(StereoEnhancerAudioProcessor& processor)
+{
+	// What getStateInformation wrote before the binary format
+	juce::MemoryBlock block;
+	std::unique_ptr<juce::XmlElement> xml(processor.apvts.copyState().createXml());
+	juce::AudioProcessor::copyXmlToBinary(*xml, block);
+
+	return block;
+}
+
+template <typename Function>
+static double measureMs(Function function)
+{
+	const double start = juce::Time::getMillisecondCounterHiRes();
+	function();
+
+	return juce::Time::getMillisecondCounterHiRes() - start;
+}
+
+bool runStateBenchmark()
+{
+	std::cout << "State benchmark, " << N_INSTANCES << " instances" << std::endl;
+
+	std::vector<std::unique_ptr<StereoEnhancerAudioProcessor>> processors;
+
+	for (int i = 0; i < N_INSTANCES; i++)
+	{
+		processors.emplace_back(new StereoEnhancerAudioProcessor());
+	}
+
+	StereoEnhancerAudioProcessor source;
+	setTestValues(source);
+
+	juce::MemoryBlock binaryState;
+	source.getStateInformation(binaryState);
+	const juce::MemoryBlock legacyState = createLegacyState(source);
+
+	// Correctness
+	bool passed = true;
+
+	processors[0]->setStateInformation(binaryState.getData(), (int)binaryState.getSize());
+	passed &= hasSameValues(source, *processors[0]);
+
+	processors[1]->setStateInformation(legacyState.getData(), (int)legacyState.getSize());
+	passed &= hasSameValues(source, *processors[1]);
+
+	// Non-finite values in a corrupted blob are skipped
+	juce::MemoryBlock corruptedState(binaryState);
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	corruptedState.copyFrom(&nan, StereoEnhancerAudioProcessor::STATE_HEADER_SIZE, sizeof(float));
+
+	processors[2]->setStateInformation(binaryState.getData(), (int)binaryState.getSize());
+	processors[2]->setStateInformation(corruptedState.getData(), (int)corruptedState.getSize());
+	passed &= hasSameValues(source, *processors[2]);
+
+	// Parameters missing from an older, shorter blob fall back to their defaults
+	const int shortCount = StereoEnhancerAudioProcessor::N_STATE_PARAMS - 1;
+	juce::MemoryBlock shortState(binaryState.getData(), StereoEnhancerAudioProcessor::STATE_HEADER_SIZE + shortCount * sizeof(float));
+	const int shortCountLittleEndian = (int)juce::ByteOrder::swapIfBigEndian((juce::uint32)shortCount);
+	shortState.copyFrom(&shortCountLittleEndian, 2 * sizeof(int), sizeof(int));
+
+	StereoEnhancerAudioProcessor defaults;
+	setTestValues(*processors[3]);
+	processors[3]->setStateInformation(shortState.getData(), (int)shortState.getSize());
+
+	const auto lastName = StereoEnhancerAudioProcessor::stateParamsNames[shortCount];
+	const bool isDefault = processors[3]->apvts.getRawParameterValue(lastName)->load() == defaults.apvts.getRawParameterValue(lastName)->load();
+
+	if (!isDefault)
+		std::cout << "  " << lastName << " not reset to its default" << std::endl;
+
+	passed &= isDefault;
+
+	// Timing
+	std::vector<juce::MemoryBlock> blocks((size_t)N_INSTANCES);
+
+	const double binarySave = measureMs([&]
+	{
+		for (int i = 0; i < N_INSTANCES; i++)
+			processors[i]->getStateInformation(blocks[i]);
+	});
+
+	const double binaryLoad = measureMs([&]
+	{
+		for (int i = 0; i < N_INSTANCES; i++)
+			processors[i]->setStateInformation(binaryState.getData(), (int)binaryState.getSize());
+	});
+
+	const double legacySave = measureMs([&]
+	{
+		for (int i = 0; i < N_INSTANCES; i++)
+			blocks[i] = createLegacyState(*processors[i]);
+	});
+
+	const double legacyLoad = measureMs([&]
+	{
+		for (int i = 0; i < N_INSTANCES; i++)
+			processors[i]->setStateInformation(legacyState.getData(), (int)legacyState.getSize());
+	});
+
+	std::cout << "  binary state " << (int)binaryState.getSize() << " bytes, save " << binarySave << " ms, load " << binaryLoad << " ms" << std::endl;
+	std::cout << "  xml state    " << (int)legacyState.getSize() << " bytes, save " << legacySave << " ms, load " << legacyLoad << " ms" << std::endl;
+	std::cout << "  state round trip " << (passed ? "ok" : "FAILED") << std::endl;
+
+	return passed;
+}
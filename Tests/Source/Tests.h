@@ -0,0 +1,15 @@
+/*
+  ==============================================================================
+
+    Test and benchmark entry points, each returns false on failure.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+bool runStateBenchmark();
+bool runGoldenTests(const juce::StringArray& args);